@@ -0,0 +1,83 @@
+// Measures how long it takes to open a mapped_table and to look records up by key.
+//
+// Usage: mapped_table_open [path] [record_count]
+
+#include <chrono>       //> std::chrono::steady_clock.
+#include <cstdlib>      //> std::strtoull, std::exit.
+#include <filesystem>   //> std::filesystem::remove.
+#include <iostream>     //> std::cout.
+#include <string>       //> std::string.
+
+#include "../miroir_mapped_table.hpp"
+
+struct price_record
+{
+    unsigned long   id;
+    char            symbol[8];
+    double          price;
+    long            timestamp;
+
+    using type_info = miroir::type_info_builder<price_record>
+        ::set_name<"price_record">
+        ::add_field<&price_record::id, "id">
+        ::add_field<&price_record::symbol, "symbol">
+        ::add_field<&price_record::price, "price">
+        ::add_field<&price_record::timestamp, "timestamp">
+        ::result;
+};
+
+using price_table = miroir::mapped_table<price_record, "id">;
+
+template <typename Function>
+double milliseconds(Function&& function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    const std::string path = argc > 1 ? argv[1] : "mapped_table_open.bin";
+    const std::size_t record_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10'000'000;
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".index");
+
+    const auto build_time = milliseconds([&]
+    {
+        price_table table{path};
+        for (std::size_t i = 0; i < record_count; i++)
+        {
+            table.append({i * 7, "MIRO", i * 0.25, long(i)});
+        }
+        table.flush();
+    });
+    std::cout << "build " << record_count << " records: " << build_time << " ms\n";
+
+    std::size_t found = 0;
+    const auto open_time = milliseconds([&]
+    {
+        price_table table{path};
+        found = table.size();
+    });
+    std::cout << "open: " << open_time << " ms (" << found << " records)\n";
+
+    price_table table{path};
+    found = 0;
+    const auto lookup_time = milliseconds([&]
+    {
+        for (std::size_t i = 0; i < record_count; i += 97)
+        {
+            found += table.find(i * 7) != nullptr;
+        }
+    });
+    std::cout << "lookup: " << lookup_time * 1e6 / found << " ns per record\n";
+
+    if (found != (record_count + 96) / 97)
+    {
+        std::cout << "lookup mismatch\n";
+        std::exit(1);
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Compares reflected field access, serialization and hashing with hand-written equivalents.
+// Objects are filled by `miroir::randomize` from a seeded generator, so every run measures the same data.
+//
+// Usage: reflection_overhead [object_count] [seed]
+
+#include <chrono>       //> std::chrono::steady_clock.
+#include <cstdlib>      //> std::strtoull, std::exit.
+#include <cstring>      //> std::memcpy.
+#include <functional>   //> std::hash.
+#include <iostream>     //> std::cout.
+#include <random>       //> std::mt19937_64.
+#include <vector>       //> std::vector.
+
+#include "../miroir_algorithms.hpp"
+#include "../miroir_serialize.hpp"
+
+struct particle
+{
+    double  position[3];
+    float   velocity[3];
+    int     id;
+    short   kind;
+    bool    alive;
+
+    using type_info = miroir::type_info_builder<particle>
+        ::set_name<"particle">
+        ::add_field<&particle::position, "position">
+        ::add_field<&particle::velocity, "velocity">
+        ::add_field<&particle::id, "id">
+        ::add_field<&particle::kind, "kind">
+        ::add_field<&particle::alive, "alive">
+        ::result;
+};
+
+// Prevents the compiler from optimizing `value` away.
+template <typename T>
+void keep(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+template <typename Function>
+double nanoseconds_per_object(std::size_t object_count, Function&& function)
+{
+    // Best of five runs.
+    double best = 0;
+    for (int run = 0; run < 5; run++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / object_count;
+        if (run == 0 || time < best) best = time;
+    }
+    return best;
+}
+
+void report(const char* name, double reflected, double direct)
+{
+    std::cout << "  " << name << ": reflected " << reflected << " ns, direct " << direct << " ns, ratio " << reflected / direct << "\n";
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t object_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 42;
+
+    std::mt19937_64 generator{seed};
+    std::vector<particle> particles(object_count);
+    for (auto& particle : particles)
+    {
+        miroir::randomize(particle, generator);
+    }
+    std::cout << object_count << " particles, seed " << seed << "\n";
+
+    // Field access: sums every field.
+    double reflected_sum = 0;
+    double direct_sum = 0;
+    const auto reflected_access = nanoseconds_per_object(object_count, [&]
+    {
+        reflected_sum = 0;
+        for (const auto& particle : particles)
+        {
+            miroir::for_each_field<struct particle>([&reflected_sum, &particle]<typename FieldInfo>
+            {
+                const auto& field = FieldInfo::get_ref(particle);
+                if constexpr (std::is_array_v<typename FieldInfo::return_type>)
+                {
+                    for (const auto& element : field) reflected_sum += element;
+                }
+                else
+                {
+                    reflected_sum += field;
+                }
+            });
+        }
+        keep(reflected_sum);
+    });
+    const auto direct_access = nanoseconds_per_object(object_count, [&]
+    {
+        direct_sum = 0;
+        for (const auto& particle : particles)
+        {
+            for (const auto& element : particle.position) direct_sum += element;
+            for (const auto& element : particle.velocity) direct_sum += element;
+            direct_sum += particle.id;
+            direct_sum += particle.kind;
+            direct_sum += particle.alive;
+        }
+        keep(direct_sum);
+    });
+    report("access", reflected_access, direct_access);
+
+    // Serialization into a preallocated buffer.
+    std::vector<std::byte> reflected_data(object_count * miroir::fixed_serialized_size<particle>());
+    std::vector<std::byte> direct_data(reflected_data.size());
+    const auto reflected_serialize = nanoseconds_per_object(object_count, [&]
+    {
+        auto out = reflected_data.data();
+        for (const auto& particle : particles)
+        {
+            out = miroir::serialize(particle, out);
+        }
+        keep(out);
+    });
+    const auto direct_serialize = nanoseconds_per_object(object_count, [&]
+    {
+        auto out = direct_data.data();
+        for (const auto& particle : particles)
+        {
+            std::memcpy(out, particle.position, sizeof(particle.position)); out += sizeof(particle.position);
+            std::memcpy(out, particle.velocity, sizeof(particle.velocity)); out += sizeof(particle.velocity);
+            std::memcpy(out, &particle.id, sizeof(particle.id)); out += sizeof(particle.id);
+            std::memcpy(out, &particle.kind, sizeof(particle.kind)); out += sizeof(particle.kind);
+            std::memcpy(out, &particle.alive, sizeof(particle.alive)); out += sizeof(particle.alive);
+        }
+        keep(out);
+    });
+    report("serialize", reflected_serialize, direct_serialize);
+
+    // Hashing with the same hash functions.
+    std::uint64_t reflected_hash = 0;
+    std::uint64_t direct_hash = 0;
+    const auto reflected_hashing = nanoseconds_per_object(object_count, [&]
+    {
+        reflected_hash = 0;
+        for (const auto& particle : particles)
+        {
+            reflected_hash ^= miroir::hash(particle);
+        }
+        keep(reflected_hash);
+    });
+    const auto direct_hashing = nanoseconds_per_object(object_count, [&]
+    {
+        direct_hash = 0;
+        for (const auto& particle : particles)
+        {
+            // Arrays of floating point values are prefixed by their size.
+            std::uint64_t seed = miroir::hash_combine(0, 3);
+            for (const auto& element : particle.position) seed = miroir::hash_combine(seed, std::hash<double>{}(element));
+            seed = miroir::hash_combine(seed, 3);
+            for (const auto& element : particle.velocity) seed = miroir::hash_combine(seed, std::hash<float>{}(element));
+            seed = miroir::hash_bytes(&particle.id, sizeof(particle.id), seed);
+            seed = miroir::hash_bytes(&particle.kind, sizeof(particle.kind), seed);
+            seed = miroir::hash_bytes(&particle.alive, sizeof(particle.alive), seed);
+            direct_hash ^= seed;
+        }
+        keep(direct_hash);
+    });
+    report("hash", reflected_hashing, direct_hashing);
+
+    if (reflected_sum != direct_sum || reflected_data != direct_data || reflected_hash != direct_hash)
+    {
+        std::cout << "reflected and direct results differ\n";
+        std::exit(1);
+    }
+    return 0;
+}
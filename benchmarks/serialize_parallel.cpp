@@ -0,0 +1,120 @@
+// Measures how `serialize_parallel` and `deserialize_parallel` scale from 1 to N threads.
+//
+// Usage: serialize_parallel [record_count] [max_thread_count]
+
+#include <algorithm>    //> std::max.
+#include <chrono>       //> std::chrono::steady_clock.
+#include <cstdlib>      //> std::strtoull, std::exit.
+#include <iostream>     //> std::cout.
+#include <string>       //> std::string.
+#include <thread>       //> std::thread::hardware_concurrency.
+#include <vector>       //> std::vector.
+
+#include "../miroir_serialize.hpp"
+
+struct fixed_record
+{
+    long    id;
+    double  position[3];
+    float   health;
+    int     flags;
+
+    using type_info = miroir::type_info_builder<fixed_record>
+        ::set_name<"fixed_record">
+        ::add_field<&fixed_record::id, "id">
+        ::add_field<&fixed_record::position, "position">
+        ::add_field<&fixed_record::health, "health">
+        ::add_field<&fixed_record::flags, "flags">
+        ::result;
+};
+
+struct variable_record
+{
+    long                id;
+    std::string         name;
+    std::vector<int>    values;
+
+    using type_info = miroir::type_info_builder<variable_record>
+        ::set_name<"variable_record">
+        ::add_field<&variable_record::id, "id">
+        ::add_field<&variable_record::name, "name">
+        ::add_field<&variable_record::values, "values">
+        ::result;
+};
+
+template <typename Function>
+double seconds(Function&& function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Grows without zero-filling, so every chunk is first touched by the worker that encodes it.
+using byte_buffer = std::vector<std::byte, miroir::default_init_allocator<std::byte>>;
+
+template <typename T>
+void run(const char* name, const std::vector<T>& records, unsigned int max_thread_count)
+{
+    // Both paths start from an empty buffer: allocation and page faults are timed the same way.
+    byte_buffer expected;
+    const auto sequential_time = seconds([&] { miroir::serialize<T>(records, expected); });
+    const auto megabytes = expected.size() / 1e6;
+
+    std::cout << name << ": " << records.size() << " records, " << megabytes << " MB\n";
+    std::cout << "  sequential serialize: " << megabytes / sequential_time << " MB/s\n";
+    std::cout << "  threads  serialize MB/s  deserialize MB/s  speedup\n";
+
+    // Powers of two, then the maximum thread count.
+    std::vector<unsigned int> thread_counts;
+    for (unsigned int thread_count = 1; thread_count < max_thread_count; thread_count *= 2)
+    {
+        thread_counts.push_back(thread_count);
+    }
+    thread_counts.push_back(max_thread_count);
+
+    for (const auto thread_count : thread_counts)
+    {
+        miroir::thread_pool pool{thread_count};
+
+        byte_buffer data;
+        const auto serialize_time = seconds([&] { miroir::serialize_parallel<T>(records, data, pool); });
+
+        std::vector<T> result(records.size());
+        bool succeeded = false;
+        const auto deserialize_time = seconds([&] { succeeded = miroir::deserialize_parallel<T>(data, result, pool); });
+
+        if (data != expected || !succeeded)
+        {
+            std::cout << "  output mismatch with " << thread_count << " threads\n";
+            std::exit(1);
+        }
+
+        std::cout << "  " << thread_count
+                  << "  " << megabytes / serialize_time
+                  << "  " << megabytes / deserialize_time
+                  << "  " << sequential_time / serialize_time << "x\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t record_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    const unsigned int max_thread_count = std::max(1u, argc > 2 ? unsigned(std::strtoul(argv[2], nullptr, 10)) : std::thread::hardware_concurrency());
+
+    std::vector<fixed_record> fixed_records(record_count);
+    for (std::size_t i = 0; i < record_count; i++)
+    {
+        fixed_records[i] = {long(i), {i * 0.5, i * 1.5, i * 2.5}, float(i % 100), int(i)};
+    }
+    run("fixed_record", fixed_records, max_thread_count);
+
+    std::vector<variable_record> variable_records(record_count / 10);
+    for (std::size_t i = 0; i < variable_records.size(); i++)
+    {
+        variable_records[i] = {long(i), std::string(i % 32, 'x'), std::vector<int>(i % 16, int(i))};
+    }
+    run("variable_record", variable_records, max_thread_count);
+
+    return 0;
+}
@@ -143,8 +143,8 @@ namespace miroir
 
         static constexpr void set(declaring_type& object, return_type value) { object.*FieldPtr = value; }
 
-        static constexpr return_type* get_ptr(declaring_type& object) { return &object.*FieldPtr; }
-        static constexpr const return_type* get_ptr(const declaring_type& object) { return &object.*FieldPtr; }
+        static constexpr return_type* get_ptr(declaring_type& object) { return &(object.*FieldPtr); }
+        static constexpr const return_type* get_ptr(const declaring_type& object) { return &(object.*FieldPtr); }
 
         static constexpr return_type& get_ref(declaring_type& object) { return object.*FieldPtr; }
         static constexpr const return_type& get_ref(const declaring_type& object) { return object.*FieldPtr; }
@@ -276,8 +276,8 @@ namespace miroir
     {
         using result = type_info<T, Name, field_info_list<FieldsInfo...>, method_info_list<MethodsInfo...>>;
 
-        template <const_string Name>
-        using set_name = type_info_builder<T, Name, field_info_list<FieldsInfo...>, method_info_list<MethodsInfo...>>;
+        template <const_string NewName>
+        using set_name = type_info_builder<T, NewName, field_info_list<FieldsInfo...>, method_info_list<MethodsInfo...>>;
 
         template <auto FieldPtr, const_string FieldName>
         using add_field = type_info_builder<T, Name, field_info_list<FieldsInfo..., field_info<FieldPtr, FieldName>>, method_info_list<MethodsInfo...>>;
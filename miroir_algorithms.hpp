@@ -0,0 +1,266 @@
+#ifndef MIROIR_ALGORITHMS_HPP
+#define MIROIR_ALGORITHMS_HPP
+
+#include <concepts>     //> std::equality_comparable.
+#include <cstddef>      //> std::size_t.
+#include <cstdint>      //> std::uint64_t.
+#include <cstring>      //> std::memcpy, std::memcmp.
+#include <functional>   //> std::hash.
+#include <limits>       //> std::numeric_limits.
+#include <random>       //> std::uniform_random_bit_generator.
+#include <type_traits>  //> std::has_unique_object_representations_v, std::underlying_type_t.
+
+#include "miroir_field_traits.hpp"
+
+// Generic algorithms over reflected types.
+//
+// Every algorithm walks the reflected fields and dispatches on their field_kind: contiguous containers of scalars
+// are handled as a single block of memory, and recursion only happens for elements that are not scalars.
+namespace miroir
+{
+    // Tells if the given scalar type is compared through its bytes by `equal`, so that it can also be hashed through them.
+    // Types with their own `operator==` are only compared bytewise if they are arithmetic or enumerations.
+    template <typename T>
+    concept bitwise_comparable = scalar_field<T> &&
+                                 std::has_unique_object_representations_v<T> &&
+                                 (std::is_arithmetic_v<T> || std::is_enum_v<T> || !std::equality_comparable<T>);
+
+    // Mixes `value` into `seed`.
+    constexpr std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t value)
+    {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+    // Hashes a block of memory, eight bytes at a time.
+    // Its results are stored in mapped_table index files: changing them requires increasing `index_hash_version`.
+    inline std::uint64_t hash_bytes(const void* data, std::size_t size, std::uint64_t seed = 0)
+    {
+        constexpr std::uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+        const auto mix = [](std::uint64_t word)
+        {
+            word ^= word >> 31;
+            word *= 0xbf58476d1ce4e5b9ull;
+            return word ^ (word >> 29);
+        };
+
+        auto bytes = static_cast<const unsigned char*>(data);
+        std::uint64_t hash = seed ^ (size * multiplier);
+        for (; size >= sizeof(std::uint64_t); bytes += sizeof(std::uint64_t), size -= sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes, sizeof(word));
+            hash = (hash ^ mix(word)) * multiplier;
+        }
+        if (size > 0)
+        {
+            std::uint64_t word = 0;
+            std::memcpy(&word, bytes, size);
+            hash = (hash ^ mix(word)) * multiplier;
+        }
+        return hash ^ (hash >> 32);
+    }
+
+    // Hashes every reflected field of the given object.
+    template <classified_field T>
+    std::uint64_t hash(const T& object, std::uint64_t seed = 0)
+    {
+        constexpr auto kind = field_kind_of<T>;
+        if constexpr (kind == field_kind::reflected)
+        {
+            for_each_field<T>([&object, &seed]<typename FieldInfo>
+            {
+                seed = hash(FieldInfo::get_ref(object), seed);
+            });
+            return seed;
+        }
+        else if constexpr (kind == field_kind::scalar)
+        {
+            if constexpr (bitwise_comparable<T>)
+            {
+                return hash_bytes(&object, sizeof(T), seed);
+            }
+            else
+            {
+                return hash_combine(seed, std::hash<T>{}(object));
+            }
+        }
+        else
+        {
+            using traits = contiguous_traits<T>;
+            using element_type = container_element_t<T>;
+
+            const auto data = traits::data(object);
+            const auto count = traits::size(object);
+            if constexpr (bitwise_comparable<element_type>)
+            {
+                return hash_bytes(data, count * sizeof(element_type), seed);
+            }
+            else
+            {
+                seed = hash_combine(seed, count);
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    seed = hash(data[i], seed);
+                }
+                return seed;
+            }
+        }
+    }
+
+    // Tells if every reflected field of both objects are equal.
+    template <classified_field T>
+    constexpr bool equal(const T& left, const T& right)
+    {
+        constexpr auto kind = field_kind_of<T>;
+        if constexpr (kind == field_kind::reflected)
+        {
+            bool result = true;
+            for_each_field<T>([&left, &right, &result]<typename FieldInfo>
+            {
+                result = result && equal(FieldInfo::get_ref(left), FieldInfo::get_ref(right));
+            });
+            return result;
+        }
+        else if constexpr (kind == field_kind::scalar)
+        {
+            static_assert(std::equality_comparable<T> || bitwise_comparable<T>,
+                          "scalar fields must either be equality comparable or have unique object representations");
+            if constexpr (bitwise_comparable<T>)
+            {
+                return std::memcmp(&left, &right, sizeof(T)) == 0;
+            }
+            else
+            {
+                return left == right;
+            }
+        }
+        else
+        {
+            using traits = contiguous_traits<T>;
+            using element_type = container_element_t<T>;
+
+            const auto count = traits::size(left);
+            if (count != traits::size(right)) return false;
+            if (count == 0) return true;
+
+            const auto left_data = traits::data(left);
+            const auto right_data = traits::data(right);
+            if constexpr (bitwise_comparable<element_type>)
+            {
+                return std::memcmp(left_data, right_data, count * sizeof(element_type)) == 0;
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    if (!equal(left_data[i], right_data[i])) return false;
+                }
+                return true;
+            }
+        }
+    }
+
+    // Copies every reflected field of `from` into `to`.
+    // Members that are not reflected are left untouched.
+    template <classified_field T>
+    constexpr void copy(const T& from, T& to)
+    {
+        constexpr auto kind = field_kind_of<T>;
+        if constexpr (kind == field_kind::reflected)
+        {
+            for_each_field<T>([&from, &to]<typename FieldInfo>
+            {
+                copy(FieldInfo::get_ref(from), FieldInfo::get_ref(to));
+            });
+        }
+        else if constexpr (kind == field_kind::scalar)
+        {
+            to = from;
+        }
+        else
+        {
+            using traits = contiguous_traits<T>;
+
+            const auto count = traits::size(from);
+            if constexpr (traits::resizable)
+            {
+                traits::resize(to, count);
+            }
+            if (count == 0) return;
+
+            const auto from_data = traits::data(from);
+            const auto to_data = traits::data(to);
+            if constexpr (kind == field_kind::contiguous_trivial)
+            {
+                std::memcpy(to_data, from_data, count * sizeof(container_element_t<T>));
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    copy(from_data[i], to_data[i]);
+                }
+            }
+        }
+    }
+
+    // Fills every reflected field of `object` with values drawn from `generator`.
+    // Values only depend on the generator state: a seeded std::mt19937_64 produces the same objects on every platform.
+    // Resizable containers get between 0 and `max_size` elements.
+    template <classified_field T, std::uniform_random_bit_generator Generator>
+    void randomize(T& object, Generator& generator, std::size_t max_size = 16)
+    {
+        static_assert(Generator::min() == 0 && Generator::max() == std::numeric_limits<std::uint64_t>::max(),
+                      "the generator must produce 64 random bits per call");
+
+        constexpr auto kind = field_kind_of<T>;
+        if constexpr (kind == field_kind::reflected)
+        {
+            for_each_field<T>([&object, &generator, max_size]<typename FieldInfo>
+            {
+                randomize(FieldInfo::get_ref(object), generator, max_size);
+            });
+        }
+        else if constexpr (kind == field_kind::scalar)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                object = generator() & 1;
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                // Uniform in [0, 1): as many high bits as the mantissa holds, so the value is never rounded up to 1.
+                constexpr int bits = std::numeric_limits<T>::digits < 64 ? std::numeric_limits<T>::digits : 64;
+                object = static_cast<T>(generator() >> (64 - bits)) / static_cast<T>(std::uint64_t{1} << (bits - 1)) / 2;
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                object = static_cast<T>(generator());
+            }
+            else
+            {
+                // Random bytes could be invalid values of scalars enabled through enable_scalar_field.
+                static_assert(std::is_enum_v<T>, "only arithmetic and enumeration scalars can be randomized");
+
+                // Any value of the underlying type, which is not necessarily one of the enumerators.
+                object = static_cast<T>(static_cast<std::underlying_type_t<T>>(generator()));
+            }
+        }
+        else
+        {
+            using traits = contiguous_traits<T>;
+
+            if constexpr (traits::resizable)
+            {
+                traits::resize(object, generator() % (max_size + 1));
+            }
+            const auto data = traits::data(object);
+            for (std::size_t i = 0; i < traits::size(object); i++)
+            {
+                randomize(data[i], generator, max_size);
+            }
+        }
+    }
+}
+
+#endif // MIROIR_ALGORITHMS_HPP
@@ -0,0 +1,154 @@
+#ifndef MIROIR_FIELD_TRAITS_HPP
+#define MIROIR_FIELD_TRAITS_HPP
+
+#include <array>        //> std::array.
+#include <concepts>     //> std::same_as.
+#include <cstddef>      //> std::size_t.
+#include <string>       //> std::basic_string.
+#include <type_traits>  //> std::is_trivially_copyable_v.
+#include <vector>       //> std::vector.
+
+#include "miroir.hpp"
+
+namespace miroir
+{
+    // Describes a contiguous container.
+    // Specializes this class to let generic algorithms handle other containers. A specialization exposes:
+    //  - `element_type`: the type of the elements,
+    //  - `resizable`: true if the element count can change at runtime,
+    //  - `extent`: the element count, only if the container is not resizable,
+    //  - `data(container)` and `size(container)`,
+    //  - `resize(container, size)`, only if the container is resizable.
+    template <typename T>
+    struct contiguous_traits;
+
+    template <typename T, std::size_t N>
+    struct contiguous_traits<T[N]>
+    {
+        using element_type = T;
+
+        static constexpr bool resizable = false;
+        static constexpr std::size_t extent = N;
+
+        static constexpr T* data(T (&array)[N]) { return array; }
+        static constexpr const T* data(const T (&array)[N]) { return array; }
+        static constexpr std::size_t size(const T (&)[N]) { return N; }
+    };
+
+    template <typename T, std::size_t N>
+    struct contiguous_traits<std::array<T, N>>
+    {
+        using element_type = T;
+
+        static constexpr bool resizable = false;
+        static constexpr std::size_t extent = N;
+
+        static constexpr T* data(std::array<T, N>& array) { return array.data(); }
+        static constexpr const T* data(const std::array<T, N>& array) { return array.data(); }
+        static constexpr std::size_t size(const std::array<T, N>&) { return N; }
+    };
+
+    // std::vector<bool> does not store its elements contiguously.
+    template <typename T, typename Allocator>
+    requires (!std::same_as<T, bool>)
+    struct contiguous_traits<std::vector<T, Allocator>>
+    {
+        using element_type = T;
+
+        static constexpr bool resizable = true;
+
+        static constexpr T* data(std::vector<T, Allocator>& vector) { return vector.data(); }
+        static constexpr const T* data(const std::vector<T, Allocator>& vector) { return vector.data(); }
+        static constexpr std::size_t size(const std::vector<T, Allocator>& vector) { return vector.size(); }
+        static constexpr void resize(std::vector<T, Allocator>& vector, std::size_t size) { vector.resize(size); }
+    };
+
+    template <typename Char, typename Traits, typename Allocator>
+    struct contiguous_traits<std::basic_string<Char, Traits, Allocator>>
+    {
+        using element_type = Char;
+
+        static constexpr bool resizable = true;
+
+        static constexpr Char* data(std::basic_string<Char, Traits, Allocator>& string) { return string.data(); }
+        static constexpr const Char* data(const std::basic_string<Char, Traits, Allocator>& string) { return string.data(); }
+        static constexpr std::size_t size(const std::basic_string<Char, Traits, Allocator>& string) { return string.size(); }
+        static constexpr void resize(std::basic_string<Char, Traits, Allocator>& string, std::size_t size) { string.resize(size); }
+    };
+
+    // Tells if the given type is a contiguous container known by miroir.
+    template <typename T>
+    concept contiguous_container = requires { typename contiguous_traits<T>::element_type; } && !reflected_type<T>;
+
+    // Shortcut for contiguous_traits<T>::element_type.
+    template <contiguous_container T>
+    using container_element_t = typename contiguous_traits<T>::element_type;
+
+    // Tells if objects of the given non-reflected type are plain values: copied, written and stored as their bytes.
+    // True for arithmetic and enumeration types. Specialize it for other trivially copyable types that hold no pointer:
+    // types such as std::string_view refer to memory of the current process and are never handled as values.
+    template <typename T>
+    constexpr bool enable_scalar_field = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+    // Tells if the given type is handled as a single value: an enabled, trivially copyable type that is neither a pointer,
+    // reflected nor a container.
+    template <typename T>
+    concept scalar_field = enable_scalar_field<std::remove_cv_t<T>> &&
+                           std::is_trivially_copyable_v<T> &&
+                           !std::is_pointer_v<T> &&
+                           !reflected_type<T> &&
+                           !contiguous_container<T>;
+
+    // How generic algorithms walk a field.
+    enum class field_kind
+    {
+        // Handled as a single value.
+        scalar,
+
+        // Handled field by field.
+        reflected,
+
+        // Contiguous container of scalars: handled as a single block of memory.
+        contiguous_trivial,
+
+        // Contiguous container of anything else, usually reflected types: handled element by element.
+        contiguous_reflected,
+    };
+
+    // Classifies a type into a field_kind.
+    template <typename T>
+    struct field_traits;
+
+    template <scalar_field T>
+    struct field_traits<T>
+    {
+        static constexpr auto kind = field_kind::scalar;
+    };
+
+    template <reflected_type T>
+    struct field_traits<T>
+    {
+        static constexpr auto kind = field_kind::reflected;
+    };
+
+    template <contiguous_container T>
+    struct field_traits<T>
+    {
+        static constexpr auto kind = scalar_field<container_element_t<T>> ? field_kind::contiguous_trivial
+                                                                          : field_kind::contiguous_reflected;
+    };
+
+    // Tells if the given type can be classified into a field_kind.
+    template <typename T>
+    concept classified_field = requires { field_traits<T>::kind; };
+
+    // Shortcut for field_traits<T>::kind.
+    template <classified_field T>
+    constexpr field_kind field_kind_of = field_traits<T>::kind;
+
+    // Returns the kind of the field described by the given field_info.
+    template <typename FieldInfo>
+    constexpr field_kind get_field_kind = field_kind_of<std::remove_cv_t<typename FieldInfo::return_type>>;
+}
+
+#endif // MIROIR_FIELD_TRAITS_HPP
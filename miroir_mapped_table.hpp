@@ -0,0 +1,617 @@
+#ifndef MIROIR_MAPPED_TABLE_HPP
+#define MIROIR_MAPPED_TABLE_HPP
+
+#include <algorithm>    //> std::max.
+#include <array>        //> std::array.
+#include <bit>          //> std::bit_ceil, std::has_single_bit.
+#include <cerrno>       //> errno.
+#include <concepts>     //> std::default_initializable.
+#include <cstddef>      //> std::byte, std::size_t.
+#include <cstdint>      //> std::uint32_t, std::uint64_t.
+#include <cstring>      //> std::memcpy, std::memcmp, std::memset.
+#include <limits>       //> std::numeric_limits.
+#include <span>         //> std::span.
+#include <stdexcept>    //> std::runtime_error.
+#include <string>       //> std::string.
+#include <system_error> //> std::system_error.
+#include <type_traits>  //> std::is_trivially_copyable_v.
+#include <utility>      //> std::exchange.
+
+#include <fcntl.h>      //> open.
+#include <sys/mman.h>   //> mmap, munmap, msync.
+#include <sys/stat.h>   //> fstat.
+#include <unistd.h>     //> close, ftruncate.
+
+#include "miroir_algorithms.hpp"
+
+// Append-only, memory-mapped tables of reflected records.
+//
+// A table is made of two files:
+//  - `path`: a header, the schema generated from the reflected fields, then every record stored as-is,
+//  - `path.index`: an open-addressing hash index on the key field.
+// Records are read in place through the mapping: opening a table never deserializes anything.
+// Files are stored in native byte order and are not meant to be shared between architectures.
+namespace miroir
+{
+    // Thrown when a file does not hold a table of the reflected type it is opened with.
+    class schema_mismatch : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    // A read-write shared mapping of a whole file, which can grow.
+    class mapped_file
+    {
+    public:
+        mapped_file() = default;
+
+        // Opens the given file, creating it if it does not exist.
+        explicit mapped_file(const std::string& path)
+        {
+            descriptor_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (descriptor_ < 0) throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+
+            struct stat status;
+            if (::fstat(descriptor_, &status) < 0)
+            {
+                const auto error = errno;
+                ::close(descriptor_);
+                throw std::system_error(error, std::generic_category(), "cannot stat " + path);
+            }
+            size_ = static_cast<std::size_t>(status.st_size);
+
+            try
+            {
+                map();
+            }
+            catch (...)
+            {
+                ::close(descriptor_);
+                throw;
+            }
+        }
+
+        mapped_file(mapped_file&& other) noexcept
+            : descriptor_(std::exchange(other.descriptor_, -1)),
+              data_(std::exchange(other.data_, nullptr)),
+              size_(std::exchange(other.size_, 0)) {}
+
+        mapped_file& operator=(mapped_file&& other) noexcept
+        {
+            if (this != &other)
+            {
+                close();
+                descriptor_ = std::exchange(other.descriptor_, -1);
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+
+        ~mapped_file() { close(); }
+
+        std::byte* data() const { return data_; }
+        std::size_t size() const { return size_; }
+
+        // Resizes the file and maps it again: every pointer to the previous mapping is invalidated.
+        void resize(std::size_t size)
+        {
+            unmap();
+            if (::ftruncate(descriptor_, static_cast<off_t>(size)) < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "cannot resize mapped file");
+            }
+            size_ = size;
+            map();
+        }
+
+        // Writes the mapping back to the file.
+        void sync()
+        {
+            if (data_ && ::msync(data_, size_, MS_SYNC) < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "cannot sync mapped file");
+            }
+        }
+
+    private:
+        void map()
+        {
+            if (size_ == 0) return;
+            void* data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor_, 0);
+            if (data == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "cannot map file");
+            data_ = static_cast<std::byte*>(data);
+        }
+
+        void unmap()
+        {
+            if (data_) ::munmap(data_, size_);
+            data_ = nullptr;
+        }
+
+        void close()
+        {
+            unmap();
+            if (descriptor_ >= 0) ::close(descriptor_);
+            descriptor_ = -1;
+        }
+
+        int descriptor_ = -1;
+        std::byte* data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+    // Returns the size of a struct made of the reflected fields of the given type, in the order they are reflected.
+    template <reflected_type T>
+    consteval std::size_t reflected_layout_size()
+    {
+        std::size_t size = 0;
+        std::size_t alignment = alignof(T);
+        for_each_field<T>([&size, &alignment]<typename FieldInfo>
+        {
+            using field_type = typename FieldInfo::return_type;
+            size = (size + alignof(field_type) - 1) / alignof(field_type) * alignof(field_type) + sizeof(field_type);
+            alignment = std::max(alignment, alignof(field_type));
+        });
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    // Tells if objects of the given type can be stored as-is in a file and read back by another process.
+    // Only arithmetic and enumeration types, types opted in with enable_scalar_field, mappable reflected types and
+    // non-resizable arrays of those can: pointers, and types that refer to memory such as std::string_view, cannot.
+    // Reflected types must reflect every member, in declaration order: the schema only describes reflected fields,
+    // so members that are not reflected could not be checked on open. Only members small enough to fit in padding escape this check.
+    template <typename T>
+    consteval bool is_mappable()
+    {
+        if constexpr (reflected_type<T>)
+        {
+            bool result = std::is_trivially_copyable_v<T> && reflected_layout_size<T>() == sizeof(T);
+            for_each_field<T>([&result]<typename FieldInfo>
+            {
+                result = result && is_mappable<std::remove_cv_t<typename FieldInfo::return_type>>();
+            });
+            return result;
+        }
+        else if constexpr (contiguous_container<T>)
+        {
+            return !contiguous_traits<T>::resizable &&
+                   std::is_trivially_copyable_v<T> &&
+                   is_mappable<container_element_t<T>>();
+        }
+        else
+        {
+            // Non-reflected types must be explicitly enabled as values, pointer-free by contract.
+            return scalar_field<T>;
+        }
+    }
+
+    // Tells if the given reflected type can be stored in a mapped_table.
+    template <typename T>
+    concept mappable_record = reflected_type<T> && std::default_initializable<T> && is_mappable<T>();
+
+    // How a field is stored, as written in a table schema.
+    enum class schema_type : std::uint32_t
+    {
+        boolean = 1,
+        signed_integer,
+        unsigned_integer,
+        floating_point,
+        enumeration,
+        reflected,
+        array,
+        other,
+    };
+
+    // Describes a reflected field in a table schema.
+    struct schema_field
+    {
+        char name[48];
+        std::uint32_t type;
+        std::uint32_t size;
+        std::uint64_t offset;
+
+        // Hash of the layout of nested reflected types and arrays, 0 for other types.
+        std::uint64_t layout;
+    };
+
+    // Returns how the given type is stored.
+    template <typename T>
+    constexpr schema_type get_schema_type()
+    {
+        if constexpr (std::is_same_v<T, bool>) return schema_type::boolean;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) return schema_type::signed_integer;
+        else if constexpr (std::is_integral_v<T>) return schema_type::unsigned_integer;
+        else if constexpr (std::is_floating_point_v<T>) return schema_type::floating_point;
+        else if constexpr (std::is_enum_v<T>) return schema_type::enumeration;
+        else if constexpr (reflected_type<T>) return schema_type::reflected;
+        else if constexpr (contiguous_container<T>) return schema_type::array;
+        else return schema_type::other;
+    }
+
+    template <typename T>
+    std::uint64_t get_schema_layout();
+
+    // Generates the schema of every reflected field of the given type.
+    template <mappable_record T>
+    std::array<schema_field, field_count<T>()> make_schema()
+    {
+        std::array<schema_field, field_count<T>()> schema{};
+        const T object{};
+        std::size_t index = 0;
+        for_each_field<T>([&schema, &object, &index]<typename FieldInfo>
+        {
+            using field_type = std::remove_cv_t<typename FieldInfo::return_type>;
+            static_assert(sizeof(FieldInfo::name.value) <= sizeof(schema_field::name), "field name is too long for a table schema");
+
+            auto& field = schema[index++];
+            std::memcpy(field.name, FieldInfo::name.value, sizeof(FieldInfo::name.value));
+            field.type = static_cast<std::uint32_t>(get_schema_type<field_type>());
+            field.size = sizeof(field_type);
+            field.offset = static_cast<std::uint64_t>(reinterpret_cast<const std::byte*>(FieldInfo::get_ptr(object)) -
+                                                      reinterpret_cast<const std::byte*>(&object));
+            field.layout = get_schema_layout<field_type>();
+        });
+        return schema;
+    }
+
+    // Hashes the layout of nested reflected types and arrays.
+    template <typename T>
+    std::uint64_t get_schema_layout()
+    {
+        if constexpr (reflected_type<T>)
+        {
+            const auto schema = make_schema<T>();
+            return hash_bytes(schema.data(), schema.size() * sizeof(schema_field), sizeof(T));
+        }
+        else if constexpr (contiguous_container<T>)
+        {
+            using element_type = container_element_t<T>;
+            std::uint64_t layout = hash_combine(contiguous_traits<T>::extent, sizeof(element_type));
+            layout = hash_combine(layout, static_cast<std::uint64_t>(get_schema_type<element_type>()));
+            return hash_combine(layout, get_schema_layout<element_type>());
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    // The first bytes of a table file.
+    struct mapped_table_header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t field_count;
+        std::uint64_t record_size;
+        std::uint64_t record_alignment;
+        std::uint64_t records_offset;
+        std::uint64_t record_count;
+        std::uint64_t schema_hash;
+        std::uint32_t key_field;
+        std::uint32_t reserved;
+        char type_name[64];
+    };
+
+    // Version of `hash_index_key`, stored in index files: indexes built by another version are rebuilt on open.
+    // Must be increased whenever the hash of any key changes, including through `hash_bytes`.
+    constexpr std::uint32_t index_hash_version = 1;
+
+    // Hashes a key of a persistent index.
+    // Unlike `hash`, never relies on std::hash: the result only depends on the value of the key, so that indexes stay
+    // valid across standard libraries. Floating point keys are hashed through their bytes, with -0 hashed as 0.
+    template <typename T>
+    std::uint64_t hash_index_key(const T& key, std::uint64_t seed = 0)
+    {
+        if constexpr (reflected_type<T>)
+        {
+            for_each_field<T>([&key, &seed]<typename FieldInfo>
+            {
+                seed = hash_index_key(FieldInfo::get_ref(key), seed);
+            });
+            return seed;
+        }
+        else if constexpr (contiguous_container<T>)
+        {
+            using element_type = container_element_t<T>;
+
+            const auto data = contiguous_traits<T>::data(key);
+            const auto count = contiguous_traits<T>::size(key);
+            if constexpr (bitwise_comparable<element_type>)
+            {
+                return hash_bytes(data, count * sizeof(element_type), seed);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    seed = hash_index_key(data[i], seed);
+                }
+                return seed;
+            }
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            static_assert(std::numeric_limits<T>::is_iec559 && (sizeof(T) == sizeof(float) || sizeof(T) == sizeof(double)),
+                          "floating point keys must be IEEE 754 single or double precision values");
+            const T value = key == 0 ? T{0} : key;
+            return hash_bytes(&value, sizeof(T), seed);
+        }
+        else
+        {
+            static_assert(bitwise_comparable<T>, "index keys must be compared through their bytes");
+            return hash_bytes(&key, sizeof(T), seed);
+        }
+    }
+
+    // The first bytes of a table index file, followed by `capacity` slots.
+    // A slot holds 0 if it is empty, or the index of a record plus one.
+    struct mapped_index_header
+    {
+        char magic[8];
+        std::uint64_t schema_hash;
+        std::uint64_t capacity;
+        std::uint64_t count;
+
+        // The index_hash_version that placed the keys in the slots.
+        std::uint32_t hash_version;
+        std::uint32_t reserved;
+    };
+
+    // An append-only table of reflected records stored in a memory-mapped file, indexed on the field named `KeyField`.
+    // Keys are unique. Appending may remap the file: references to records are invalidated by `append`.
+    // A table must not be opened more than once at the same time.
+    template <mappable_record T, const_string KeyField>
+    class mapped_table
+    {
+    public:
+        using key_info = get_field_info<T, KeyField>;
+        using key_type = std::remove_cv_t<typename key_info::return_type>;
+
+        static constexpr std::uint32_t version = 1;
+
+        // Opens the table stored at `path`, creating it if it does not exist.
+        // Throws schema_mismatch if the file holds something else than a table of `T` indexed on `KeyField`.
+        explicit mapped_table(const std::string& path)
+            : records_file_{path}, index_file_{path + ".index"}
+        {
+            const auto expected = make_header();
+            const auto schema = make_schema<T>();
+
+            if (records_file_.size() == 0)
+            {
+                records_file_.resize(expected.records_offset);
+                std::memcpy(records_file_.data(), &expected, sizeof(expected));
+                std::memcpy(records_file_.data() + sizeof(expected), schema.data(), sizeof(schema));
+            }
+            else
+            {
+                check_schema(expected, schema);
+            }
+
+            if (!index_valid())
+            {
+                rebuild_index(index_capacity(size()));
+            }
+        }
+
+        // Returns the number of records.
+        std::size_t size() const { return header().record_count; }
+
+        bool empty() const { return size() == 0; }
+
+        // Returns every record, read in place.
+        std::span<const T> records() const
+        {
+            return {reinterpret_cast<const T*>(records_file_.data() + header().records_offset), size()};
+        }
+
+        const T& operator[](std::size_t index) const { return records()[index]; }
+
+        // Returns the record with the given key, or nullptr if there is none.
+        const T* find(const key_type& key) const
+        {
+            const auto slots = index_slots();
+            const auto mask = index_header().capacity - 1;
+            const auto count = size();
+            auto slot = hash_index_key(key) & mask;
+            for (std::size_t probe = 0; probe <= mask && slots[slot] != 0; probe++, slot = (slot + 1) & mask)
+            {
+                // Slots are read from the file: out of range record indices are skipped.
+                const auto record_index = slots[slot] - 1;
+                if (record_index < count && equal(key_info::get_ref(records()[record_index]), key)) return &records()[record_index];
+            }
+            return nullptr;
+        }
+
+        // Appends a record to the table.
+        // Returns false if a record with the same key already exists.
+        bool append(const T& record)
+        {
+            if (find(key_info::get_ref(record))) return false;
+
+            const auto count = size();
+            const auto capacity = (records_file_.size() - header().records_offset) / sizeof(T);
+            if (count == capacity)
+            {
+                records_file_.resize(header().records_offset + std::max<std::size_t>(64, capacity * 2) * sizeof(T));
+            }
+            std::memcpy(records_file_.data() + header().records_offset + count * sizeof(T), &record, sizeof(T));
+            header().record_count = count + 1;
+
+            if ((count + 1) * 2 > index_header().capacity)
+            {
+                rebuild_index(index_header().capacity * 2);
+            }
+            else if (insert(count))
+            {
+                index_header().count = count + 1;
+            }
+            else
+            {
+                rebuild_index(index_header().capacity);
+            }
+            return true;
+        }
+
+        // Writes every change back to the files.
+        void flush()
+        {
+            records_file_.sync();
+            index_file_.sync();
+        }
+
+    private:
+        static consteval std::uint32_t key_field_index()
+        {
+            std::uint32_t index = 0;
+            std::uint32_t result = 0;
+            for_each_field<T>([&index, &result]<typename FieldInfo>
+            {
+                if (FieldInfo::name == KeyField) result = index;
+                index++;
+            });
+            return result;
+        }
+
+        static mapped_table_header make_header()
+        {
+            static_assert(sizeof(get_type_name<T>().value) <= sizeof(mapped_table_header::type_name), "type name is too long for a table header");
+
+            mapped_table_header header{};
+            std::memcpy(header.magic, "miroirtb", 8);
+            header.version = version;
+            header.field_count = field_count<T>();
+            header.record_size = sizeof(T);
+            header.record_alignment = alignof(T);
+            header.record_count = 0;
+            header.schema_hash = hash_combine(get_schema_layout<T>(), key_field_index());
+            header.key_field = key_field_index();
+            std::memcpy(header.type_name, get_type_name<T>().value, sizeof(get_type_name<T>().value));
+
+            // Records start on their own cache line, right after the schema.
+            const std::size_t alignment = std::max<std::size_t>(alignof(T), 64);
+            const std::size_t schema_end = sizeof(mapped_table_header) + field_count<T>() * sizeof(schema_field);
+            header.records_offset = (schema_end + alignment - 1) / alignment * alignment;
+            return header;
+        }
+
+        void check_schema(const mapped_table_header& expected, const std::array<schema_field, field_count<T>()>& schema) const
+        {
+            if (records_file_.size() < sizeof(mapped_table_header) || std::memcmp(header().magic, expected.magic, 8) != 0)
+            {
+                throw schema_mismatch("not a miroir table");
+            }
+
+            const auto& actual = header();
+            if (actual.version != expected.version)
+            {
+                throw schema_mismatch("unsupported table version");
+            }
+            if (std::memcmp(actual.type_name, expected.type_name, sizeof(expected.type_name)) != 0)
+            {
+                throw schema_mismatch("table holds another type");
+            }
+            if (actual.field_count != expected.field_count ||
+                actual.record_size != expected.record_size ||
+                actual.record_alignment != expected.record_alignment ||
+                actual.records_offset != expected.records_offset ||
+                actual.key_field != expected.key_field ||
+                actual.schema_hash != expected.schema_hash)
+            {
+                throw schema_mismatch("table schema does not match the reflected fields");
+            }
+
+            // The schema ends before `records_offset`: it is only read once the file is known to hold it.
+            if (records_file_.size() < expected.records_offset ||
+                actual.record_count > (records_file_.size() - expected.records_offset) / sizeof(T))
+            {
+                throw std::runtime_error("table file is truncated");
+            }
+            if (std::memcmp(records_file_.data() + sizeof(mapped_table_header), schema.data(), sizeof(schema)) != 0)
+            {
+                throw schema_mismatch("table schema does not match the reflected fields");
+            }
+        }
+
+        // Tells if the index file holds an index of every record, with a capacity that lookups can rely on:
+        // a power of two with at least half of the slots empty, so that every probe sequence ends.
+        bool index_valid() const
+        {
+            if (index_file_.size() < sizeof(mapped_index_header)) return false;
+
+            const auto& index = index_header();
+            const auto slots_size = index_file_.size() - sizeof(mapped_index_header);
+            return std::memcmp(index.magic, "miroirix", 8) == 0 &&
+                   index.schema_hash == header().schema_hash &&
+                   index.hash_version == index_hash_version &&
+                   index.count == size() &&
+                   std::has_single_bit(index.capacity) &&
+                   index.capacity / 2 >= index.count &&
+                   slots_size % sizeof(std::uint64_t) == 0 &&
+                   index.capacity == slots_size / sizeof(std::uint64_t);
+        }
+
+        // Returns the number of index slots needed for the given record count.
+        static std::size_t index_capacity(std::size_t count)
+        {
+            return std::bit_ceil(std::max<std::size_t>(16, count * 2));
+        }
+
+        void rebuild_index(std::size_t capacity)
+        {
+            index_file_.resize(sizeof(mapped_index_header) + capacity * sizeof(std::uint64_t));
+
+            auto& index = index_header();
+            std::memcpy(index.magic, "miroirix", 8);
+            index.schema_hash = header().schema_hash;
+            index.capacity = capacity;
+            index.hash_version = index_hash_version;
+            std::memset(index_slots(), 0, capacity * sizeof(std::uint64_t));
+            for (std::size_t i = 0; i < size(); i++)
+            {
+                insert(i);
+            }
+            index.count = size();
+        }
+
+        // Returns false if every slot is taken, which only happens if the index file was corrupted.
+        bool insert(std::size_t record_index)
+        {
+            const auto& key = key_info::get_ref(records()[record_index]);
+            const auto slots = index_slots();
+            const auto mask = index_header().capacity - 1;
+            auto slot = hash_index_key(key) & mask;
+            for (std::size_t probe = 0; probe <= mask; probe++, slot = (slot + 1) & mask)
+            {
+                if (slots[slot] == 0)
+                {
+                    slots[slot] = record_index + 1;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        mapped_table_header& header() const
+        {
+            return *reinterpret_cast<mapped_table_header*>(records_file_.data());
+        }
+
+        mapped_index_header& index_header() const
+        {
+            return *reinterpret_cast<mapped_index_header*>(index_file_.data());
+        }
+
+        std::uint64_t* index_slots() const
+        {
+            return reinterpret_cast<std::uint64_t*>(index_file_.data() + sizeof(mapped_index_header));
+        }
+
+        mapped_file records_file_;
+        mapped_file index_file_;
+    };
+}
+
+#endif // MIROIR_MAPPED_TABLE_HPP
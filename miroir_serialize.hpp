@@ -0,0 +1,647 @@
+#ifndef MIROIR_SERIALIZE_HPP
+#define MIROIR_SERIALIZE_HPP
+
+#include <algorithm>            //> std::min, std::max.
+#include <atomic>               //> std::atomic.
+#include <condition_variable>   //> std::condition_variable_any.
+#include <cstddef>              //> std::byte, std::size_t.
+#include <cstdint>              //> std::uint64_t.
+#include <cstring>              //> std::memcpy.
+#include <deque>                //> std::deque.
+#include <exception>            //> std::exception_ptr.
+#include <functional>           //> std::function.
+#include <latch>                //> std::latch.
+#include <memory>               //> std::allocator, std::construct_at.
+#include <mutex>                //> std::mutex.
+#include <span>                 //> std::span.
+#include <thread>               //> std::jthread.
+#include <type_traits>          //> std::is_nothrow_default_constructible_v.
+#include <utility>              //> std::forward.
+#include <vector>               //> std::vector.
+
+#include "miroir_field_traits.hpp"
+
+// Binary serialization of reflected types.
+//
+// The wire format is the concatenation of every reflected field, in declaration order, in native byte order.
+// Padding and non-reflected members are never written. Resizable containers are prefixed by their element count as a 64-bit integer.
+namespace miroir
+{
+    // Describes how a type is written to and read from a byte buffer.
+    // Specializes this class to make a non-reflected type serializable. A specialization exposes:
+    //  - `fixed_size`: true if every object of the type has the same serialized size,
+    //  - `size`: that serialized size, only if `fixed_size` is true,
+    //  - `size_of(object)`: the number of bytes written for `object`,
+    //  - `write(object, out)`: writes `object` to `out` and returns the end of the written bytes,
+    //  - `read(object, in, end)`: reads `object` from `[in, end)` and returns the end of the read bytes, or nullptr if the input is malformed,
+    //  - `skip(in, end)`: same as `read` but discards the object.
+    template <typename T>
+    struct serializer;
+
+    // Tells if the given type can be serialized by miroir.
+    template <typename T>
+    concept serializable = requires { serializer<T>::fixed_size; };
+
+    // Tells if every object of the given type has the same serialized size.
+    template <serializable T>
+    constexpr bool has_fixed_serialized_size = serializer<T>::fixed_size;
+
+    template <serializable T>
+    requires has_fixed_serialized_size<T>
+    constexpr std::size_t fixed_serialized_size();
+
+    template <serializable T>
+    constexpr std::size_t min_serialized_size();
+
+    // Raw copy of scalars.
+    template <scalar_field T>
+    struct serializer<T>
+    {
+        static constexpr bool fixed_size = true;
+        static constexpr std::size_t size = sizeof(T);
+
+        static constexpr std::size_t size_of(const T&) { return sizeof(T); }
+
+        static std::byte* write(const T& object, std::byte* out)
+        {
+            std::memcpy(out, &object, sizeof(T));
+            return out + sizeof(T);
+        }
+
+        static const std::byte* read(T& object, const std::byte* in, const std::byte* end)
+        {
+            if (static_cast<std::size_t>(end - in) < sizeof(T)) return nullptr;
+            std::memcpy(&object, in, sizeof(T));
+            return in + sizeof(T);
+        }
+
+        static const std::byte* skip(const std::byte* in, const std::byte* end)
+        {
+            if (static_cast<std::size_t>(end - in) < sizeof(T)) return nullptr;
+            return in + sizeof(T);
+        }
+    };
+
+    // Contiguous containers: the element count if the container is resizable, followed by every element.
+    // Containers of scalars are copied as a single block of memory.
+    template <contiguous_container T>
+    requires serializable<container_element_t<T>>
+    struct serializer<T>
+    {
+        using traits = contiguous_traits<T>;
+        using element_type = container_element_t<T>;
+
+        static constexpr bool trivial = field_kind_of<T> == field_kind::contiguous_trivial;
+
+        static constexpr bool fixed_size = !traits::resizable && serializer<element_type>::fixed_size;
+
+        static constexpr std::size_t size_of(const T& container)
+        {
+            std::size_t size = traits::resizable ? sizeof(std::uint64_t) : 0;
+            if constexpr (trivial)
+            {
+                size += traits::size(container) * sizeof(element_type);
+            }
+            else
+            {
+                const auto data = traits::data(container);
+                for (std::size_t i = 0; i < traits::size(container); i++)
+                {
+                    size += serializer<element_type>::size_of(data[i]);
+                }
+            }
+            return size;
+        }
+
+        static std::byte* write(const T& container, std::byte* out)
+        {
+            const auto data = traits::data(container);
+            const auto count = traits::size(container);
+            if constexpr (traits::resizable)
+            {
+                out = serializer<std::uint64_t>::write(count, out);
+            }
+            if constexpr (trivial)
+            {
+                if (count > 0) std::memcpy(out, data, count * sizeof(element_type));
+                return out + count * sizeof(element_type);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    out = serializer<element_type>::write(data[i], out);
+                }
+                return out;
+            }
+        }
+
+        static const std::byte* read(T& container, const std::byte* in, const std::byte* end)
+        {
+            std::size_t count = traits::size(container);
+            if constexpr (traits::resizable)
+            {
+                std::uint64_t stored_count;
+                if (!(in = serializer<std::uint64_t>::read(stored_count, in, end))) return nullptr;
+                if (!count_fits(stored_count, in, end)) return nullptr;
+                count = stored_count;
+                traits::resize(container, count);
+            }
+            const auto data = traits::data(container);
+            if constexpr (trivial)
+            {
+                if (!traits::resizable && count > static_cast<std::size_t>(end - in) / sizeof(element_type)) return nullptr;
+                if (count > 0) std::memcpy(data, in, count * sizeof(element_type));
+                return in + count * sizeof(element_type);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    if (!(in = serializer<element_type>::read(data[i], in, end))) return nullptr;
+                }
+                return in;
+            }
+        }
+
+        static const std::byte* skip(const std::byte* in, const std::byte* end)
+        {
+            std::uint64_t count;
+            if constexpr (traits::resizable)
+            {
+                if (!(in = serializer<std::uint64_t>::read(count, in, end))) return nullptr;
+                if (!count_fits(count, in, end)) return nullptr;
+            }
+            else
+            {
+                count = traits::extent;
+            }
+            if constexpr (trivial)
+            {
+                if (count > static_cast<std::size_t>(end - in) / sizeof(element_type)) return nullptr;
+                return in + count * sizeof(element_type);
+            }
+            else
+            {
+                for (std::uint64_t i = 0; i < count; i++)
+                {
+                    if (!(in = serializer<element_type>::skip(in, end))) return nullptr;
+                }
+                return in;
+            }
+        }
+
+    private:
+        // Rejects counts of elements that cannot fit in the input, before allocating anything.
+        static bool count_fits(std::uint64_t count, const std::byte* in, const std::byte* end)
+        {
+            constexpr auto element_size = min_serialized_size<element_type>();
+            return element_size == 0 || count <= static_cast<std::size_t>(end - in) / element_size;
+        }
+    };
+
+    // Tells if every reflected field of the given type is serializable.
+    template <reflected_type T>
+    consteval bool reflected_fields_serializable()
+    {
+        bool result = true;
+        for_each_field<T>([&result]<typename FieldInfo>
+        {
+            result = result && serializable<typename FieldInfo::return_type>;
+        });
+        return result;
+    }
+
+    // Tells if every reflected field of the given type has a fixed serialized size.
+    template <reflected_type T>
+    consteval bool reflected_fields_fixed_size()
+    {
+        bool result = true;
+        for_each_field<T>([&result]<typename FieldInfo>
+        {
+            result = result && serializer<typename FieldInfo::return_type>::fixed_size;
+        });
+        return result;
+    }
+
+    // Reflected types: every reflected field, in declaration order.
+    template <reflected_type T>
+    requires (reflected_fields_serializable<T>())
+    struct serializer<T>
+    {
+        static constexpr bool fixed_size = reflected_fields_fixed_size<T>();
+
+        static constexpr std::size_t size_of(const T& object)
+        {
+            std::size_t size = 0;
+            for_each_field<T>([&size, &object]<typename FieldInfo>
+            {
+                size += serializer<typename FieldInfo::return_type>::size_of(FieldInfo::get_ref(object));
+            });
+            return size;
+        }
+
+        static std::byte* write(const T& object, std::byte* out)
+        {
+            for_each_field<T>([&object, &out]<typename FieldInfo>
+            {
+                out = serializer<typename FieldInfo::return_type>::write(FieldInfo::get_ref(object), out);
+            });
+            return out;
+        }
+
+        static const std::byte* read(T& object, const std::byte* in, const std::byte* end)
+        {
+            for_each_field<T>([&object, &in, end]<typename FieldInfo>
+            {
+                if (in) in = serializer<typename FieldInfo::return_type>::read(FieldInfo::get_ref(object), in, end);
+            });
+            return in;
+        }
+
+        static const std::byte* skip(const std::byte* in, const std::byte* end)
+        {
+            for_each_field<T>([&in, end]<typename FieldInfo>
+            {
+                if (in) in = serializer<typename FieldInfo::return_type>::skip(in, end);
+            });
+            return in;
+        }
+    };
+
+    // Returns the number of bytes written when serializing the given object.
+    template <serializable T>
+    constexpr std::size_t serialized_size(const T& object)
+    {
+        return serializer<T>::size_of(object);
+    }
+
+    // Returns the number of bytes written when serializing any object of a type with a fixed serialized size.
+    // Only the reflected field types are used: no object is needed.
+    // Reflected types and containers are computed from their elements; other types provide `serializer<T>::size`.
+    template <serializable T>
+    requires has_fixed_serialized_size<T>
+    constexpr std::size_t fixed_serialized_size()
+    {
+        std::size_t size = 0;
+        if constexpr (reflected_type<T>)
+        {
+            for_each_field<T>([&size]<typename FieldInfo>
+            {
+                size += fixed_serialized_size<typename FieldInfo::return_type>();
+            });
+        }
+        else if constexpr (contiguous_container<T>)
+        {
+            size = contiguous_traits<T>::extent * fixed_serialized_size<container_element_t<T>>();
+        }
+        else
+        {
+            size = serializer<T>::size;
+        }
+        return size;
+    }
+
+    // Returns the smallest number of bytes written when serializing any object of the given type.
+    // Used to reject malformed element counts; 0 if it is unknown.
+    template <serializable T>
+    constexpr std::size_t min_serialized_size()
+    {
+        std::size_t size = 0;
+        if constexpr (has_fixed_serialized_size<T>)
+        {
+            size = fixed_serialized_size<T>();
+        }
+        else if constexpr (reflected_type<T>)
+        {
+            for_each_field<T>([&size]<typename FieldInfo>
+            {
+                size += min_serialized_size<typename FieldInfo::return_type>();
+            });
+        }
+        else if constexpr (contiguous_container<T>)
+        {
+            if constexpr (contiguous_traits<T>::resizable)
+            {
+                size = sizeof(std::uint64_t);
+            }
+            else
+            {
+                size = contiguous_traits<T>::extent * min_serialized_size<container_element_t<T>>();
+            }
+        }
+        return size;
+    }
+
+    // Writes the given object to `out` and returns the end of the written bytes.
+    // `out` must hold at least `serialized_size(object)` bytes.
+    template <serializable T>
+    std::byte* serialize(const T& object, std::byte* out)
+    {
+        return serializer<T>::write(object, out);
+    }
+
+    // Reads an object from `[in, end)` and returns the end of the read bytes, or nullptr if the input is malformed.
+    template <serializable T>
+    const std::byte* deserialize(T& object, const std::byte* in, const std::byte* end)
+    {
+        return serializer<T>::read(object, in, end);
+    }
+
+    // An allocator that default-initializes elements instead of value-initializing them.
+    // Growing a `std::vector<std::byte, default_init_allocator<std::byte>>` leaves the new bytes untouched:
+    // they are neither zero-filled nor faulted in until they are written.
+    template <typename T>
+    struct default_init_allocator : std::allocator<T>
+    {
+        default_init_allocator() noexcept = default;
+
+        template <typename U>
+        default_init_allocator(const default_init_allocator<U>&) noexcept {}
+
+        template <typename U>
+        void construct(U* pointer) noexcept(std::is_nothrow_default_constructible_v<U>)
+        {
+            ::new (static_cast<void*>(pointer)) U;
+        }
+
+        template <typename U, typename... Args>
+        void construct(U* pointer, Args&&... args)
+        {
+            std::construct_at(pointer, std::forward<Args>(args)...);
+        }
+    };
+
+    // Appends every object of the given span to `sink`.
+    template <serializable T, typename Allocator>
+    void serialize(std::span<const T> objects, std::vector<std::byte, Allocator>& sink)
+    {
+        std::size_t size = 0;
+        if constexpr (has_fixed_serialized_size<T>)
+        {
+            size = objects.size() * fixed_serialized_size<T>();
+        }
+        else
+        {
+            for (const auto& object : objects)
+            {
+                size += serialized_size(object);
+            }
+        }
+
+        const auto base = sink.size();
+        sink.resize(base + size);
+        auto out = sink.data() + base;
+        for (const auto& object : objects)
+        {
+            out = serialize(object, out);
+        }
+    }
+
+    // Reads every object of the given span from `data`.
+    // Returns false if `data` is malformed or does not hold exactly `objects.size()` objects.
+    template <serializable T>
+    bool deserialize(std::span<const std::byte> data, std::span<T> objects)
+    {
+        const std::byte* in = data.data();
+        const std::byte* end = data.data() + data.size();
+        for (auto& object : objects)
+        {
+            if (!(in = deserialize(object, in, end))) return false;
+        }
+        return in == end;
+    }
+
+    // A work-stealing thread pool used by the parallel algorithms.
+    // Every worker owns a task queue that it consumes from the back; idle workers steal from the front of the other queues.
+    class thread_pool
+    {
+    public:
+        explicit thread_pool(unsigned int thread_count = std::thread::hardware_concurrency())
+            : queues_(std::max(thread_count, 1u))
+        {
+            workers_.reserve(queues_.size());
+            for (std::size_t i = 0; i < queues_.size(); i++)
+            {
+                workers_.emplace_back([this, i](std::stop_token stop) { work(i, stop); });
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        // Returns the number of worker threads.
+        std::size_t size() const { return workers_.size(); }
+
+        // Calls `function(i)` for every `i` in `[0, count)` on the workers and waits for every call to finish.
+        // The first exception thrown by a call is rethrown once every call is finished.
+        // Must not be called from a task of the same pool.
+        template <typename Function>
+        void parallel_for(std::size_t count, Function&& function)
+        {
+            if (count == 0) return;
+
+            std::latch done{static_cast<std::ptrdiff_t>(count)};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            {
+                std::lock_guard lock{sleep_mutex_};
+                pending_ += count;
+            }
+            for (std::size_t i = 0; i < count; i++)
+            {
+                auto& queue = queues_[i % queues_.size()];
+                std::lock_guard lock{queue.mutex};
+                queue.tasks.emplace_back([&function, &done, &error, &error_mutex, i]
+                {
+                    try
+                    {
+                        function(i);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard lock{error_mutex};
+                        if (!error) error = std::current_exception();
+                    }
+                    done.count_down();
+                });
+            }
+            sleep_cv_.notify_all();
+
+            done.wait();
+            if (error) std::rethrow_exception(error);
+        }
+
+    private:
+        struct task_queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        bool pop(std::size_t index, std::function<void()>& task)
+        {
+            for (std::size_t i = 0; i < queues_.size(); i++)
+            {
+                auto& queue = queues_[(index + i) % queues_.size()];
+                std::lock_guard lock{queue.mutex};
+                if (queue.tasks.empty()) continue;
+                if (i == 0)
+                {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else
+                {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                pending_--;
+                return true;
+            }
+            return false;
+        }
+
+        void work(std::size_t index, std::stop_token stop)
+        {
+            while (!stop.stop_requested())
+            {
+                std::function<void()> task;
+                if (pop(index, task))
+                {
+                    task();
+                    continue;
+                }
+                std::unique_lock lock{sleep_mutex_};
+                sleep_cv_.wait(lock, stop, [this] { return pending_ > 0; });
+            }
+        }
+
+        std::vector<task_queue> queues_;
+        std::atomic<std::size_t> pending_{0};
+        std::mutex sleep_mutex_;
+        std::condition_variable_any sleep_cv_;
+
+        // Declared last so that workers are joined before anything else is destroyed.
+        std::vector<std::jthread> workers_;
+    };
+
+    // Returns the number of chunks a span of `count` objects is split into by the parallel algorithms.
+    inline std::size_t parallel_chunk_count(std::size_t count, const thread_pool& pool)
+    {
+        return std::min(count, pool.size() * 8);
+    }
+
+    // Appends every object of the given span to `sink` using every worker of `pool`.
+    // The span is split into chunks whose exact output sizes are computed up front, then every chunk is
+    // encoded into its own region of `sink`: the output is identical to `serialize(objects, sink)`.
+    // With a default_init_allocator, `sink` grows without being zero-filled, so every worker is the first to touch
+    // the pages of its own region; std::allocator zero-fills the whole output on the calling thread first.
+    template <serializable T, typename Allocator>
+    void serialize_parallel(std::span<const T> objects, std::vector<std::byte, Allocator>& sink, thread_pool& pool)
+    {
+        const auto chunk_count = parallel_chunk_count(objects.size(), pool);
+        if (chunk_count == 0) return;
+
+        const auto chunk_begin = [&objects, chunk_count](std::size_t chunk)
+        {
+            return objects.size() * chunk / chunk_count;
+        };
+
+        // offsets[i] is the offset of chunk `i` in the output; offsets[chunk_count] is the output size.
+        std::vector<std::size_t> offsets(chunk_count + 1, 0);
+        if constexpr (has_fixed_serialized_size<T>)
+        {
+            for (std::size_t chunk = 0; chunk <= chunk_count; chunk++)
+            {
+                offsets[chunk] = chunk_begin(chunk) * fixed_serialized_size<T>();
+            }
+        }
+        else
+        {
+            pool.parallel_for(chunk_count, [&objects, &offsets, &chunk_begin](std::size_t chunk)
+            {
+                std::size_t size = 0;
+                for (auto i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++)
+                {
+                    size += serialized_size(objects[i]);
+                }
+                offsets[chunk + 1] = size;
+            });
+            for (std::size_t chunk = 0; chunk < chunk_count; chunk++)
+            {
+                offsets[chunk + 1] += offsets[chunk];
+            }
+        }
+
+        const auto base = sink.size();
+        sink.resize(base + offsets[chunk_count]);
+        const auto out = sink.data() + base;
+        pool.parallel_for(chunk_count, [&objects, &offsets, &chunk_begin, out](std::size_t chunk)
+        {
+            auto chunk_out = out + offsets[chunk];
+            for (auto i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++)
+            {
+                chunk_out = serialize(objects[i], chunk_out);
+            }
+        });
+    }
+
+    // Reads every object of the given span from `data` using every worker of `pool`.
+    // Returns false if `data` is malformed or does not hold exactly `objects.size()` objects.
+    // Chunk boundaries of types without a fixed serialized size are found by a sequential pass that skips over the objects.
+    template <serializable T>
+    bool deserialize_parallel(std::span<const std::byte> data, std::span<T> objects, thread_pool& pool)
+    {
+        const auto chunk_count = parallel_chunk_count(objects.size(), pool);
+        if (chunk_count == 0) return data.empty();
+
+        const auto chunk_begin = [&objects, chunk_count](std::size_t chunk)
+        {
+            return objects.size() * chunk / chunk_count;
+        };
+
+        const std::byte* begin = data.data();
+        const std::byte* end = data.data() + data.size();
+
+        std::vector<std::size_t> offsets(chunk_count + 1, 0);
+        if constexpr (has_fixed_serialized_size<T>)
+        {
+            if (data.size() != objects.size() * fixed_serialized_size<T>()) return false;
+            for (std::size_t chunk = 0; chunk <= chunk_count; chunk++)
+            {
+                offsets[chunk] = chunk_begin(chunk) * fixed_serialized_size<T>();
+            }
+        }
+        else
+        {
+            const std::byte* in = begin;
+            for (std::size_t chunk = 0; chunk < chunk_count; chunk++)
+            {
+                offsets[chunk] = static_cast<std::size_t>(in - begin);
+                for (auto i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++)
+                {
+                    if (!(in = serializer<T>::skip(in, end))) return false;
+                }
+            }
+            if (in != end) return false;
+            offsets[chunk_count] = data.size();
+        }
+
+        std::atomic<bool> succeeded{true};
+        pool.parallel_for(chunk_count, [&objects, &offsets, &chunk_begin, &succeeded, begin](std::size_t chunk)
+        {
+            const std::byte* in = begin + offsets[chunk];
+            const std::byte* chunk_end = begin + offsets[chunk + 1];
+            for (auto i = chunk_begin(chunk); i < chunk_begin(chunk + 1); i++)
+            {
+                if (!(in = deserialize(objects[i], in, chunk_end))) break;
+            }
+            if (in != chunk_end) succeeded = false;
+        });
+        return succeeded;
+    }
+}
+
+#endif // MIROIR_SERIALIZE_HPP
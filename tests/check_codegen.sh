@@ -0,0 +1,83 @@
+#!/bin/sh
+# Checks that reflection primitives compile down to direct member access.
+#
+# Compiles `codegen.cpp` at -O2 and compares every `reflected_*` function with its `direct_*` counterpart.
+# Fails if a reflected function is longer, or calls or jumps to a function that its counterpart does not:
+# a helper that stops being inlined shows up as such a call.
+#
+# Usage: check_codegen.sh [extra compiler flags...]
+# Passing -O0 or -fno-inline must make the check fail.
+# Set CXX and OBJDUMP to use other tools.
+
+set -e
+
+CXX=${CXX:-c++}
+OBJDUMP=${OBJDUMP:-objdump}
+DIRECTORY=$(cd "$(dirname "$0")" && pwd)
+OBJECT=$(mktemp)
+trap 'rm -f "$OBJECT"' EXIT
+
+"$CXX" -std=c++20 -O2 "$@" -c "$DIRECTORY/codegen.cpp" -o "$OBJECT"
+
+# Prints "<function> <instruction count> <called symbols>" for every function, ignoring alignment padding.
+# Called symbols are separated by commas, or "-" if there are none.
+describe_functions()
+{
+    "$OBJDUMP" -dr --no-show-raw-insn "$OBJECT" | awk '
+        function add_symbol(symbol)
+        {
+            sub(/[+-]0x[0-9a-f]+$/, "", symbol)
+            if (symbol == "" || symbol == function_name || index("," symbols[function_name] ",", "," symbol ",")) return
+            symbols[function_name] = symbols[function_name] (symbols[function_name] == "" ? "" : ",") symbol
+        }
+        /^[0-9a-f]+ <.*>:$/ { function_name = substr($2, 2, length($2) - 3); counts[function_name] = 0; symbols[function_name] = ""; next }
+        function_name == "" { next }
+        /R_[A-Z0-9_]+/ { add_symbol($NF); next }
+        /^ *[0-9a-f]+:\t/ {
+            split($0, columns, "\t")
+            instruction = columns[2]
+            if (instruction ~ /^(nop|xchg +%ax,%ax|data16|cs nop|int3)/) next
+            counts[function_name]++
+            if (instruction ~ /^(call|jmp|j[a-z]+) / && match(instruction, /<[^>]+>/))
+            {
+                add_symbol(substr(instruction, RSTART + 1, RLENGTH - 2))
+            }
+        }
+        END { for (name in counts) print name, counts[name], (symbols[name] == "" ? "-" : symbols[name]) }'
+}
+
+descriptions=$(describe_functions)
+failed=0
+for reflected in $(echo "$descriptions" | awk '$1 ~ /^reflected_/ { print $1 }' | sort); do
+    direct="direct_${reflected#reflected_}"
+    reflected_count=$(echo "$descriptions" | awk -v name="$reflected" '$1 == name { print $2 }')
+    reflected_symbols=$(echo "$descriptions" | awk -v name="$reflected" '$1 == name { print $3 }')
+    direct_count=$(echo "$descriptions" | awk -v name="$direct" '$1 == name { print $2 }')
+    direct_symbols=$(echo "$descriptions" | awk -v name="$direct" '$1 == name { print $3 }')
+    if [ -z "$direct_count" ]; then
+        echo "missing $direct"
+        failed=1
+        continue
+    fi
+
+    extra_symbols=""
+    for symbol in $(echo "$reflected_symbols" | tr ',' ' '); do
+        [ "$symbol" = "-" ] && continue
+        case ",$direct_symbols," in
+            *",$symbol,"*) ;;
+            *) extra_symbols="$extra_symbols $symbol" ;;
+        esac
+    done
+
+    if [ -n "$extra_symbols" ]; then
+        echo "FAILED $reflected calls functions that $direct does not:$extra_symbols"
+        failed=1
+    elif [ "$reflected_count" -gt "$direct_count" ]; then
+        echo "FAILED $reflected: $reflected_count instructions, $direct: $direct_count"
+        failed=1
+    else
+        echo "ok     $reflected: $reflected_count instructions, $direct: $direct_count"
+    fi
+done
+
+exit $failed
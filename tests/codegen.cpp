@@ -0,0 +1,90 @@
+// Pairs of functions checked by `check_codegen.sh`.
+// Every `reflected_*` function must not compile to more instructions, or call more functions, than its `direct_*` counterpart.
+
+#include <cstring>
+
+#include "test_data.hpp"
+#include "../miroir_algorithms.hpp"
+#include "../miroir_serialize.hpp"
+
+struct codegen_counter
+{
+    int value;
+    int step;
+
+    void advance(int times) { value += step * times; }
+
+    using type_info = miroir::type_info_builder<codegen_counter>
+        ::set_name<"codegen_counter">
+        ::add_field<&codegen_counter::value, "value">
+        ::add_field<&codegen_counter::step, "step">
+        ::add_method<&codegen_counter::advance, "advance">
+        ::result;
+};
+
+extern "C"
+{
+    float reflected_get_ref(const reflected_character& character)
+    {
+        return miroir::get_field_info<reflected_character, "mana">::get_ref(character);
+    }
+    float direct_get_ref(const reflected_character& character)
+    {
+        return character.mana;
+    }
+
+    void reflected_set(reflected_pos2d& position, int y)
+    {
+        miroir::get_field_info<reflected_pos2d, "y">::set(position, y);
+    }
+    void direct_set(reflected_pos2d& position, int y)
+    {
+        position.y = y;
+    }
+
+    void reflected_invoke(codegen_counter& counter, int times)
+    {
+        miroir::invoke<"advance">(counter, times);
+    }
+    void direct_invoke(codegen_counter& counter, int times)
+    {
+        counter.advance(times);
+    }
+
+    float reflected_for_each_field(const reflected_character& character)
+    {
+        float sum = 0;
+        miroir::for_each_field<reflected_character>([&sum, &character]<typename FieldInfo>
+        {
+            sum += FieldInfo::get_ref(character);
+        });
+        return sum;
+    }
+    float direct_for_each_field(const reflected_character& character)
+    {
+        float sum = 0;
+        sum += character.hp;
+        sum += character.mana;
+        return sum;
+    }
+
+    std::byte* reflected_serialize(const reflected_pos2d& position, std::byte* out)
+    {
+        return miroir::serialize(position, out);
+    }
+    std::byte* direct_serialize(const reflected_pos2d& position, std::byte* out)
+    {
+        std::memcpy(out, &position.x, sizeof(position.x));
+        std::memcpy(out + sizeof(position.x), &position.y, sizeof(position.y));
+        return out + sizeof(position.x) + sizeof(position.y);
+    }
+
+    std::uint64_t reflected_hash(const reflected_pos2d& position)
+    {
+        return miroir::hash(position);
+    }
+    std::uint64_t direct_hash(const reflected_pos2d& position)
+    {
+        return miroir::hash_bytes(&position.y, sizeof(position.y), miroir::hash_bytes(&position.x, sizeof(position.x)));
+    }
+}
@@ -1,8 +1,16 @@
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <type_traits>
 #include <iostream>
+#include <random>
+#include <string_view>
 
 #include "test_data.hpp"
+#include "../miroir_algorithms.hpp"
+#include "../miroir_mapped_table.hpp"
+#include "../miroir_serialize.hpp"
 
 void _ensure(bool expr, int line)
 {
@@ -121,6 +129,381 @@ void test_type_info()
     ensure(miroir::get_type_info<reflected_character_array>::name == MIROIR_TESTS_REFLECTED_CHARACTER_ARRAY_TYPE_NAME);
 }
 
+std::vector<reflected_party> make_parties(int count)
+{
+    std::vector<reflected_party> parties(count);
+    for (int i = 0; i < count; i++)
+    {
+        parties[i].name = std::string(i % 7, 'a' + i % 26);
+        parties[i].members.resize(i % 5);
+        for (int j = 0; j < i % 5; j++)
+        {
+            parties[i].members[j] = {float(i + j), float(i * j)};
+        }
+        parties[i].position = {i, -i};
+    }
+    return parties;
+}
+
+bool operator==(const reflected_party& left, const reflected_party& right)
+{
+    if (left.name != right.name || left.members.size() != right.members.size()) return false;
+    for (std::size_t i = 0; i < left.members.size(); i++)
+    {
+        if (left.members[i].hp != right.members[i].hp || left.members[i].mana != right.members[i].mana) return false;
+    }
+    return left.position.x == right.position.x && left.position.y == right.position.y;
+}
+
+// Fixed size type that is not default constructible, with a custom serializer.
+struct serialized_handle
+{
+    explicit serialized_handle(int value) : value(value) {}
+
+    int value;
+};
+template <> struct miroir::serializer<serialized_handle>
+{
+    static constexpr bool fixed_size = true;
+    static constexpr std::size_t size = sizeof(int);
+
+    static constexpr std::size_t size_of(const serialized_handle&) { return size; }
+    static std::byte* write(const serialized_handle& handle, std::byte* out) { return serializer<int>::write(handle.value, out); }
+    static const std::byte* read(serialized_handle& handle, const std::byte* in, const std::byte* end) { return serializer<int>::read(handle.value, in, end); }
+    static const std::byte* skip(const std::byte* in, const std::byte* end) { return serializer<int>::skip(in, end); }
+};
+
+void test_serialized_size()
+{
+    ensure(miroir::has_fixed_serialized_size<reflected_character>);
+    ensure(miroir::has_fixed_serialized_size<reflected_character_array>);
+    ensure(!miroir::has_fixed_serialized_size<reflected_party>);
+    ensure(!miroir::serializable<not_reflected_character*>);
+    ensure(miroir::fixed_serialized_size<reflected_character>() == 2 * sizeof(float));
+    ensure(miroir::fixed_serialized_size<reflected_character_array>() == 10 * sizeof(float));
+    ensure(miroir::fixed_serialized_size<serialized_handle>() == sizeof(int));
+    ensure((miroir::fixed_serialized_size<serialized_handle[3]>() == 3 * sizeof(int)));
+
+    reflected_party party{"abc", {{1, 2}, {3, 4}}, {5, 6}};
+    ensure(miroir::serialized_size(party) == sizeof(std::uint64_t) + 3 + sizeof(std::uint64_t) + 4 * sizeof(float) + 2 * sizeof(int));
+}
+
+void test_serialize_round_trip()
+{
+    const auto parties = make_parties(100);
+    std::vector<std::byte> data;
+    miroir::serialize<reflected_party>(parties, data);
+
+    std::vector<reflected_party> result(parties.size());
+    ensure(miroir::deserialize<reflected_party>(data, result));
+    ensure(result == parties);
+
+    // Truncated and oversized inputs are rejected.
+    ensure(!miroir::deserialize<reflected_party>(std::span{data}.first(data.size() - 1), result));
+    data.push_back(std::byte{0});
+    ensure(!miroir::deserialize<reflected_party>(data, result));
+
+    // Element counts that cannot fit in the input are rejected before allocating.
+    std::vector<std::byte> malformed(3 * sizeof(std::uint64_t));
+    const std::uint64_t huge_count = std::uint64_t{1} << 60;
+    std::memcpy(malformed.data() + sizeof(std::uint64_t), &huge_count, sizeof(huge_count));
+    ensure(!miroir::deserialize<reflected_party>(malformed, std::span{result}.first(1)));
+
+    std::vector<std::string> strings;
+    std::memcpy(malformed.data(), &huge_count, sizeof(huge_count));
+    ensure(!miroir::deserialize(strings, malformed.data(), malformed.data() + malformed.size()));
+}
+
+void test_serialize_parallel()
+{
+    miroir::thread_pool pool{4};
+
+    const auto parties = make_parties(1000);
+    std::vector<std::byte> expected;
+    std::vector<std::byte> data;
+    miroir::serialize<reflected_party>(parties, expected);
+    miroir::serialize_parallel<reflected_party>(parties, data, pool);
+    ensure(data == expected);
+
+    std::vector<reflected_party> result(parties.size());
+    ensure(miroir::deserialize_parallel<reflected_party>(data, result, pool));
+    ensure(result == parties);
+    ensure(!miroir::deserialize_parallel<reflected_party>(std::span{data}.first(data.size() - 1), result, pool));
+
+    std::vector<reflected_pos2d> positions(1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        positions[i] = {i, i * 2};
+    }
+    std::vector<std::byte> expected_positions;
+    std::vector<std::byte> positions_data;
+    miroir::serialize<reflected_pos2d>(positions, expected_positions);
+    miroir::serialize_parallel<reflected_pos2d>(positions, positions_data, pool);
+    ensure(positions_data == expected_positions);
+
+    std::vector<reflected_pos2d> positions_result(positions.size());
+    ensure(miroir::deserialize_parallel<reflected_pos2d>(positions_data, positions_result, pool));
+    ensure(positions_result[999].x == 999 && positions_result[999].y == 1998);
+
+    // Sinks that are not zero-filled when they grow get the same output.
+    std::vector<std::byte, miroir::default_init_allocator<std::byte>> uninitialized_data(3);
+    miroir::serialize_parallel<reflected_pos2d>(positions, uninitialized_data, pool);
+    ensure(std::equal(uninitialized_data.begin() + 3, uninitialized_data.end(), expected_positions.begin(), expected_positions.end()));
+
+    // Empty spans produce no output.
+    std::vector<reflected_pos2d> no_positions;
+    std::vector<std::byte> empty_data;
+    miroir::serialize_parallel<reflected_pos2d>(no_positions, empty_data, pool);
+    miroir::serialize_parallel<reflected_party>(std::span<const reflected_party>{}, empty_data, pool);
+    ensure(empty_data.empty());
+    ensure(miroir::deserialize_parallel<reflected_pos2d>(empty_data, std::span<reflected_pos2d>{no_positions}, pool));
+}
+
+// Trivially copyable type without pointers, handled as a single value.
+struct packed_color
+{
+    unsigned char r, g, b, a;
+};
+template <> constexpr bool miroir::enable_scalar_field<packed_color> = true;
+
+void test_field_kind()
+{
+    using miroir::field_kind;
+    ensure((miroir::get_field_kind<miroir::get_field_info<reflected_character, "hp">> == field_kind::scalar));
+    ensure((miroir::get_field_kind<miroir::get_field_info<reflected_character_array, "characters">> == field_kind::contiguous_reflected));
+    ensure((miroir::get_field_kind<miroir::get_field_info<reflected_party, "name">> == field_kind::contiguous_trivial));
+    ensure((miroir::get_field_kind<miroir::get_field_info<reflected_party, "members">> == field_kind::contiguous_reflected));
+    ensure((miroir::get_field_kind<miroir::get_field_info<reflected_party, "position">> == field_kind::reflected));
+    ensure((miroir::get_field_kind<miroir::get_field_info<reflected_inventory, "slots">> == field_kind::contiguous_trivial));
+    ensure((miroir::get_field_kind<miroir::get_field_info<reflected_inventory, "weights">> == field_kind::contiguous_trivial));
+    ensure((miroir::get_field_kind<miroir::get_field_info<reflected_inventory, "tags">> == field_kind::contiguous_reflected));
+    ensure(!miroir::classified_field<int*>);
+    ensure(!miroir::classified_field<std::string_view>);
+    ensure(!miroir::serializable<std::string_view>);
+    ensure(miroir::scalar_field<packed_color>);
+    ensure(!miroir::contiguous_container<std::vector<bool>>);
+}
+
+void test_algorithms()
+{
+    reflected_inventory inventory{{1, 2, 3, 4}, {0.5f, 1.5f}, {"sword", "shield"}, {{10, 20}, {30, 40}}, 7};
+    reflected_inventory other{};
+    other.not_reflected = 8;
+
+    ensure(!miroir::equal(inventory, other));
+    miroir::copy(inventory, other);
+    ensure(miroir::equal(inventory, other));
+    ensure(miroir::hash(inventory) == miroir::hash(other));
+    ensure(other.not_reflected == 8);
+
+    other.tags[1] = "bow";
+    ensure(!miroir::equal(inventory, other));
+    ensure(miroir::hash(inventory) != miroir::hash(other));
+
+    other.tags[1] = "shield";
+    other.owners[1].mana = 41;
+    ensure(!miroir::equal(inventory, other));
+
+    // Scalars are hashed through their bytes only if they are also compared through them.
+    ensure(miroir::bitwise_comparable<packed_color>);
+    ensure(!miroir::bitwise_comparable<std::string_view>);
+    const packed_color color{1, 2, 3, 4};
+    const packed_color same_color{1, 2, 3, 4};
+    ensure(miroir::equal(color, same_color) && miroir::hash(color) == miroir::hash(same_color));
+    ensure(!miroir::equal(color, packed_color{1, 2, 3, 5}));
+
+    reflected_character_array array{};
+    reflected_character_array array_copy{};
+    array.characters[4].hp = 100;
+    ensure(!miroir::equal(array, array_copy));
+    miroir::copy(array, array_copy);
+    ensure(miroir::equal(array, array_copy));
+}
+
+void test_serialize_containers()
+{
+    ensure(!miroir::has_fixed_serialized_size<reflected_inventory>);
+    ensure((miroir::fixed_serialized_size<std::array<int, 4>>() == 4 * sizeof(int)));
+
+    std::vector<reflected_inventory> inventories(3);
+    inventories[0] = {{1, 2, 3, 4}, {0.5f, 1.5f}, {"sword", "shield"}, {{10, 20}, {30, 40}}, 7};
+    inventories[2] = {{5, 6, 7, 8}, {}, {"", "bow"}, {{50, 60}}, 9};
+    std::vector<std::byte> data;
+    miroir::serialize<reflected_inventory>(inventories, data);
+
+    std::vector<reflected_inventory> result(inventories.size());
+    ensure(miroir::deserialize<reflected_inventory>(data, result));
+    for (std::size_t i = 0; i < inventories.size(); i++)
+    {
+        ensure(miroir::equal(inventories[i], result[i]));
+    }
+}
+
+void test_mapped_table()
+{
+    ensure(miroir::mappable_record<reflected_account>);
+    ensure(!miroir::mappable_record<reflected_party>);
+    ensure(!miroir::mappable_record<reflected_account_with_pointer>);
+    ensure(!miroir::mappable_record<reflected_account_with_view>);
+    ensure(!miroir::is_mappable<std::string_view>());
+    ensure(!miroir::is_mappable<account_owner>());
+
+    const auto path = (std::filesystem::temp_directory_path() / "miroir_test_mapped_table").string();
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".index");
+
+    {
+        miroir::mapped_table<reflected_account, "id"> table{path};
+        ensure(table.empty());
+        for (unsigned long i = 0; i < 1000; i++)
+        {
+            ensure(table.append({i * 3, "account", double(i), {int(i), -int(i)}}));
+        }
+        ensure(!table.append({3, "duplicate", 0, {0, 0}}));
+        ensure(table.size() == 1000);
+        ensure(table.find(4) == nullptr);
+        ensure(table.find(300) != nullptr && table.find(300)->balance == 100);
+        table.flush();
+    }
+
+    {
+        miroir::mapped_table<reflected_account, "id"> table{path};
+        ensure(table.size() == 1000);
+        ensure(table[999].position.x == 999);
+        ensure(table.find(2997) == &table[999]);
+    }
+
+    // A missing index is rebuilt from the records.
+    std::filesystem::remove(path + ".index");
+    {
+        miroir::mapped_table<reflected_account, "id"> table{path};
+        ensure(table.find(1500) != nullptr && table.find(1500)->balance == 500);
+    }
+
+    // Index headers whose capacity lookups cannot rely on are rebuilt.
+    for (const std::uint64_t capacity : {0, 3, 1024})
+    {
+        {
+            miroir::mapped_table<reflected_account, "id"> table{path};
+            miroir::mapped_file index{path + ".index"};
+            auto header = *reinterpret_cast<const miroir::mapped_index_header*>(index.data());
+            header.capacity = capacity;
+            index.resize(sizeof(header) + capacity * sizeof(std::uint64_t));
+            std::memset(index.data(), 0, index.size());
+            std::memcpy(index.data(), &header, sizeof(header));
+        }
+        miroir::mapped_table<reflected_account, "id"> table{path};
+        ensure(table.find(1500) != nullptr);
+        ensure(!table.append({3, "duplicate", 0, {0, 0}}));
+    }
+
+    // Indexes built by another version of the key hash are rebuilt.
+    {
+        miroir::mapped_file index{path + ".index"};
+        auto& header = *reinterpret_cast<miroir::mapped_index_header*>(index.data());
+        header.hash_version = miroir::index_hash_version + 1;
+        std::memset(index.data() + sizeof(header), 0, index.size() - sizeof(header));
+    }
+    {
+        miroir::mapped_table<reflected_account, "id"> table{path};
+        ensure(table.find(1500) != nullptr);
+        ensure(!table.append({3, "duplicate", 0, {0, 0}}));
+    }
+
+    // Keys are hashed from their value only: equal floating point values have the same hash.
+    ensure(miroir::hash_index_key(0.0) == miroir::hash_index_key(-0.0));
+    ensure(miroir::hash_index_key(reflected_pos2d{1, 2}) != miroir::hash_index_key(reflected_pos2d{2, 1}));
+
+    // Record counts that do not fit in the file are rejected.
+    {
+        miroir::mapped_file file{path};
+        auto& header = *reinterpret_cast<miroir::mapped_table_header*>(file.data());
+        const auto record_count = header.record_count;
+        header.record_count = ~std::uint64_t{0} / sizeof(reflected_account) + 2;
+
+        bool truncated = false;
+        try
+        {
+            miroir::mapped_table<reflected_account, "id"> table{path};
+        }
+        catch (const std::runtime_error&)
+        {
+            truncated = true;
+        }
+        ensure(truncated);
+        header.record_count = record_count;
+    }
+
+    // Other types, or another key field, are rejected.
+    bool rejected = false;
+    try
+    {
+        miroir::mapped_table<reflected_account_v2, "id"> table{path};
+    }
+    catch (const miroir::schema_mismatch&)
+    {
+        rejected = true;
+    }
+    ensure(rejected);
+
+    rejected = false;
+    try
+    {
+        miroir::mapped_table<reflected_account, "balance"> table{path};
+    }
+    catch (const miroir::schema_mismatch&)
+    {
+        rejected = true;
+    }
+    ensure(rejected);
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".index");
+}
+
+void test_randomize()
+{
+    std::mt19937_64 generator{42};
+    std::mt19937_64 same_generator{42};
+    std::mt19937_64 other_generator{43};
+
+    reflected_inventory inventory{};
+    reflected_inventory same_inventory{};
+    reflected_inventory other_inventory{};
+    miroir::randomize(inventory, generator, 4);
+    miroir::randomize(same_inventory, same_generator, 4);
+    miroir::randomize(other_inventory, other_generator, 4);
+
+    ensure(miroir::equal(inventory, same_inventory));
+    ensure(!miroir::equal(inventory, other_inventory));
+    ensure(inventory.weights.size() <= 4 && inventory.tags.size() <= 4);
+    for (auto weight : inventory.weights)
+    {
+        ensure(weight >= 0 && weight < 1);
+    }
+
+    // Enumerations get a value of their underlying type.
+    enum class direction : std::uint8_t { north, east, south, west };
+    std::mt19937_64 enum_generator{7};
+    direction heading = direction::north;
+    miroir::randomize(heading, enum_generator);
+    ensure(static_cast<std::uint8_t>(heading) == static_cast<std::uint8_t>(std::mt19937_64{7}()));
+
+    // All one bits must not round up to 1.
+    struct ones_generator
+    {
+        using result_type = std::uint64_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return ~result_type{0}; }
+        result_type operator()() { return max(); }
+    } ones;
+    float single = 0;
+    double precise = 0;
+    miroir::randomize(single, ones);
+    miroir::randomize(precise, ones);
+    ensure(single < 1 && precise < 1);
+}
+
 int main()
 {
     test_const_string();
@@ -132,6 +515,14 @@ int main()
     test_get_method_info_reflected_pos2d();
     test_reflected_type_concept();
     test_type_info();
+    test_serialized_size();
+    test_serialize_round_trip();
+    test_serialize_parallel();
+    test_field_kind();
+    test_algorithms();
+    test_serialize_containers();
+    test_mapped_table();
+    test_randomize();
 
     return 0;
 }
\ No newline at end of file
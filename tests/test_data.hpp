@@ -1,6 +1,11 @@
 #ifndef MIROIR_TESTS_TEST_DATA_HPP
 #define MIROIR_TESTS_TEST_DATA_HPP
 
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "../miroir.hpp"
 
 // Invalid reflected type:
@@ -59,4 +64,105 @@ template <> struct miroir::type_info_provider<reflected_pos2d>
         ::result;
 };
 
+// Reflected type with variable size fields:
+#define MIROIR_TESTS_REFLECTED_PARTY_TYPE_NAME "reflected_party"
+struct reflected_party
+{
+    std::string name;
+    std::vector<reflected_character> members;
+    reflected_pos2d position;
+
+    using type_info = miroir::type_info_builder<reflected_party>
+        ::set_name<MIROIR_TESTS_REFLECTED_PARTY_TYPE_NAME>
+        ::add_field<&reflected_party::name, "name">
+        ::add_field<&reflected_party::members, "members">
+        ::add_field<&reflected_party::position, "position">
+        ::result;
+};
+
+// Reflected type with every kind of container field:
+#define MIROIR_TESTS_REFLECTED_INVENTORY_TYPE_NAME "reflected_inventory"
+struct reflected_inventory
+{
+    std::array<int, 4> slots;
+    std::vector<float> weights;
+    std::vector<std::string> tags;
+    std::vector<reflected_character> owners;
+    int not_reflected;
+
+    using type_info = miroir::type_info_builder<reflected_inventory>
+        ::set_name<MIROIR_TESTS_REFLECTED_INVENTORY_TYPE_NAME>
+        ::add_field<&reflected_inventory::slots, "slots">
+        ::add_field<&reflected_inventory::weights, "weights">
+        ::add_field<&reflected_inventory::tags, "tags">
+        ::add_field<&reflected_inventory::owners, "owners">
+        ::result;
+};
+
+// Reflected types that can be stored in a mapped table:
+#define MIROIR_TESTS_REFLECTED_ACCOUNT_TYPE_NAME "reflected_account"
+struct reflected_account
+{
+    unsigned long id;
+    char name[16];
+    double balance;
+    reflected_pos2d position;
+
+    using type_info = miroir::type_info_builder<reflected_account>
+        ::set_name<MIROIR_TESTS_REFLECTED_ACCOUNT_TYPE_NAME>
+        ::add_field<&reflected_account::id, "id">
+        ::add_field<&reflected_account::name, "name">
+        ::add_field<&reflected_account::balance, "balance">
+        ::add_field<&reflected_account::position, "position">
+        ::result;
+};
+
+// Same layout as `reflected_account`, but `balance` is stored as an integer.
+struct reflected_account_v2
+{
+    unsigned long id;
+    char name[16];
+    long balance;
+    reflected_pos2d position;
+
+    using type_info = miroir::type_info_builder<reflected_account_v2>
+        ::set_name<MIROIR_TESTS_REFLECTED_ACCOUNT_TYPE_NAME>
+        ::add_field<&reflected_account_v2::id, "id">
+        ::add_field<&reflected_account_v2::name, "name">
+        ::add_field<&reflected_account_v2::balance, "balance">
+        ::add_field<&reflected_account_v2::position, "position">
+        ::result;
+};
+
+// Cannot be stored in a mapped table: `owner` is not reflected.
+struct reflected_account_with_pointer
+{
+    unsigned long id;
+    const char* owner;
+
+    using type_info = miroir::type_info_builder<reflected_account_with_pointer>
+        ::set_name<"reflected_account_with_pointer">
+        ::add_field<&reflected_account_with_pointer::id, "id">
+        ::result;
+};
+
+// Cannot be stored in a mapped table: `owner` and `nickname` refer to memory of the current process.
+struct account_owner
+{
+    const char* name;
+};
+struct reflected_account_with_view
+{
+    unsigned long id;
+    std::string_view nickname;
+    account_owner owner;
+
+    using type_info = miroir::type_info_builder<reflected_account_with_view>
+        ::set_name<"reflected_account_with_view">
+        ::add_field<&reflected_account_with_view::id, "id">
+        ::add_field<&reflected_account_with_view::nickname, "nickname">
+        ::add_field<&reflected_account_with_view::owner, "owner">
+        ::result;
+};
+
 #endif // MIROIR_TESTS_TEST_DATA_HPP
\ No newline at end of file